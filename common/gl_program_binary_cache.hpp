@@ -0,0 +1,215 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <glad/glad.h>
+
+// 基于 GL_ARB_get_program_binary 的程序二进制缓存。
+// 二进制只在同一驱动下有效，因此每个文件都记录 GL_VENDOR/GL_RENDERER/GL_VERSION 等驱动信息，
+// 驱动不一致、格式不再支持、数据损坏或 glProgramBinary 链接失败时都会删除缓存文件，由调用方重新编译。
+// 使用前需要有当前上下文，并在链接前设置 GL_PROGRAM_BINARY_RETRIEVABLE_HINT。
+
+class GlProgramBinaryCache {
+public:
+    // extraDriverInfo 可以传入 GL 字符串之外的驱动构建信息（例如内核模块版本）
+    explicit GlProgramBinaryCache(const std::string& directory, const std::string& extraDriverInfo = "")
+        : m_directory(directory)
+    {
+        m_driverKey = GetString(GL_VENDOR) + "|" + GetString(GL_RENDERER) + "|" + GetString(GL_VERSION)
+            + "|" + GetString(GL_SHADING_LANGUAGE_VERSION) + "|" + extraDriverInfo;
+
+        if (IsSupported()) {
+            GLint numFormats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+            m_formats.resize(numFormats);
+            if (numFormats > 0)
+                glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_formats.data());
+        }
+    }
+
+    // 驱动可能声明支持扩展但不提供任何二进制格式，此时缓存不可用
+    static bool IsSupported() {
+        if (!(GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary))
+            return false;
+
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        return numFormats > 0;
+    }
+
+    const std::string& GetDriverKey() const { return m_driverKey; }
+    const std::vector<GLint>& GetFormats() const { return m_formats; }
+
+    // programKey 应唯一描述程序内容（例如着色器源码的哈希）。
+    // 文件名同时包含驱动与程序的哈希，多块 GPU 或多个驱动共用目录时各自的缓存互不淘汰；
+    // 文件内仍会校验完整的驱动信息与 programKey，防止哈希碰撞
+    std::string GetPath(const std::string& programKey) const {
+        char name[48];
+        std::snprintf(name, sizeof(name), "%016llx-%016llx.glbin",
+            static_cast<unsigned long long>(Hash(m_driverKey.data(), m_driverKey.size())),
+            static_cast<unsigned long long>(Hash(programKey.data(), programKey.size())));
+        return m_directory + "/" + name;
+    }
+
+    bool Store(const std::string& programKey, GLuint program) const {
+        if (m_formats.empty())
+            return false;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return false;
+
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &length, &format, binary.data());
+        binary.resize(length);
+
+        // 先写临时文件再替换，避免进程中途退出留下半个文件；
+        // 临时文件名带进程 ID 与随机数，多个进程同时写同一个程序时不会互相覆盖
+        std::string path = GetPath(programKey);
+        std::string tempPath = MakeTempPath(path);
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+
+            WriteU32(file, kMagic);
+            WriteU32(file, kFileVersion);
+            WriteString(file, m_driverKey);
+            WriteString(file, programKey);
+            WriteU32(file, format);
+            WriteU32(file, static_cast<uint32_t>(binary.size()));
+            WriteU64(file, Hash(binary.data(), binary.size()));
+            file.write(binary.data(), binary.size());
+            if (!file) {
+                file.close();
+                std::remove(tempPath.c_str());
+                return false;
+            }
+        }
+
+        // POSIX 的 rename 会原子地替换已有文件；Windows 上目标存在时会失败，需要先删除再重试
+        if (std::rename(tempPath.c_str(), path.c_str()) == 0)
+            return true;
+        std::remove(path.c_str());
+        if (std::rename(tempPath.c_str(), path.c_str()) == 0)
+            return true;
+
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    // 成功时 program 处于已链接状态；失败时缓存文件已被删除，需要重新编译
+    bool Load(const std::string& programKey, GLuint program) const {
+        std::string path = GetPath(programKey);
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        uint32_t magic = 0, fileVersion = 0, format = 0, length = 0;
+        uint64_t checksum = 0;
+        std::string driverKey, storedProgramKey;
+        bool valid = ReadU32(file, magic) && magic == kMagic
+            && ReadU32(file, fileVersion) && fileVersion == kFileVersion
+            && ReadString(file, driverKey) && driverKey == m_driverKey
+            && ReadString(file, storedProgramKey) && storedProgramKey == programKey
+            && ReadU32(file, format) && IsFormatSupported(format)
+            && ReadU32(file, length) && length <= kMaxBinarySize && ReadU64(file, checksum);
+
+        std::vector<char> binary;
+        if (valid) {
+            binary.resize(length);
+            valid = static_cast<bool>(file.read(binary.data(), length))
+                && Hash(binary.data(), binary.size()) == checksum;
+        }
+        file.close();
+
+        if (valid) {
+            glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            valid = linked == GL_TRUE;
+        }
+
+        if (!valid)
+            Invalidate(programKey);
+        return valid;
+    }
+
+    void Invalidate(const std::string& programKey) const {
+        std::remove(GetPath(programKey).c_str());
+    }
+
+    // FNV-1a，用于文件名与数据校验
+    static uint64_t Hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+private:
+    static const uint32_t kMagic = 0x42504c47; // "GLPB"
+    static const uint32_t kFileVersion = 1;
+    static const uint32_t kMaxBinarySize = 256 * 1024 * 1024;
+
+    static std::string GetString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    static std::string MakeTempPath(const std::string& path) {
+#ifdef _WIN32
+        unsigned long processId = static_cast<unsigned long>(_getpid());
+#else
+        unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+        std::random_device device;
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), ".%lu.%08x.tmp", processId, static_cast<unsigned int>(device()));
+        return path + suffix;
+    }
+
+    bool IsFormatSupported(uint32_t format) const {
+        for (GLint supported : m_formats) {
+            if (static_cast<uint32_t>(supported) == format)
+                return true;
+        }
+        return false;
+    }
+
+    static void WriteU32(std::ofstream& file, uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    static void WriteU64(std::ofstream& file, uint64_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    static void WriteString(std::ofstream& file, const std::string& value) {
+        WriteU32(file, static_cast<uint32_t>(value.size()));
+        file.write(value.data(), value.size());
+    }
+
+    static bool ReadU32(std::ifstream& file, uint32_t& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+    static bool ReadU64(std::ifstream& file, uint64_t& value) { return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value))); }
+    static bool ReadString(std::ifstream& file, std::string& value) {
+        uint32_t size = 0;
+        if (!ReadU32(file, size) || size > 4096)
+            return false;
+        value.resize(size);
+        return size == 0 || static_cast<bool>(file.read(&value[0], size));
+    }
+
+    std::string m_directory;
+    std::string m_driverKey;
+    std::vector<GLint> m_formats;
+};
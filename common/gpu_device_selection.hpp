@@ -0,0 +1,289 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// 同一块物理 GPU 在 Vulkan、OpenGL、DXGI 与 sysfs 中的标识方式各不相同，
+// 这里统一成一个结构，用于跨 API 关联设备并按性能排序挑选设备。
+
+struct GpuDeviceIdentity {
+    std::string api;            // Vulkan / OpenGL / DXGI / PCI
+    std::string name;
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+
+    bool hasUuid = false;       // Vulkan deviceUUID 与 GL_DEVICE_UUID_EXT 相同
+    uint8_t uuid[16] = {};
+
+    bool hasLuid = false;       // Vulkan deviceLUID、GL_DEVICE_LUID_EXT 与 DXGI AdapterLuid 相同（仅 Windows）
+    uint8_t luid[8] = {};
+
+    bool hasPciAddress = false; // VK_EXT_pci_bus_info 或 sysfs
+    uint32_t pciDomain = 0;
+    uint32_t pciBus = 0;
+    uint32_t pciDevice = 0;
+    uint32_t pciFunction = 0;
+};
+
+enum class GpuMatchStrength {
+    None,
+    VendorDevice,   // 只有型号相同，多卡同型号时无法区分
+    PciAddress,
+    Uuid,
+    Luid,
+};
+
+// 解析 sysfs 中的 PCI 地址，例如 "0000:01:00.0"
+inline bool ParsePciAddress(const std::string& address, GpuDeviceIdentity& identity) {
+    unsigned int domain = 0, bus = 0, device = 0, function = 0;
+    if (std::sscanf(address.c_str(), "%x:%x:%x.%x", &domain, &bus, &device, &function) != 4)
+        return false;
+
+    identity.hasPciAddress = true;
+    identity.pciDomain = domain;
+    identity.pciBus = bus;
+    identity.pciDevice = device;
+    identity.pciFunction = function;
+    return true;
+}
+
+inline std::string FormatPciAddress(const GpuDeviceIdentity& identity) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04x:%02x:%02x.%x",
+        identity.pciDomain, identity.pciBus, identity.pciDevice, identity.pciFunction);
+    return buffer;
+}
+
+inline std::string FormatBytes(const uint8_t* bytes, size_t size) {
+    std::string text;
+    char buffer[4];
+    for (size_t i = 0; i < size; ++i) {
+        std::snprintf(buffer, sizeof(buffer), "%02x", bytes[i]);
+        text += buffer;
+    }
+    return text;
+}
+
+// 各工具统一输出这一行，便于把不同进程的结果拼接起来
+inline std::string FormatDeviceKey(const GpuDeviceIdentity& identity) {
+    std::string key;
+    auto append = [&key](const std::string& field) {
+        if (!key.empty())
+            key += " ";
+        key += field;
+    };
+
+    // OpenGL 只能从 GL_VENDOR 推断厂商，没有设备 ID，此时只输出厂商
+    if (identity.vendorId != 0) {
+        char ids[32];
+        if (identity.deviceId != 0)
+            std::snprintf(ids, sizeof(ids), "%04x:%04x", identity.vendorId, identity.deviceId);
+        else
+            std::snprintf(ids, sizeof(ids), "%04x", identity.vendorId);
+        append(std::string("id=") + ids);
+    }
+    if (identity.hasPciAddress)
+        append("pci=" + FormatPciAddress(identity));
+    if (identity.hasUuid)
+        append("uuid=" + FormatBytes(identity.uuid, sizeof(identity.uuid)));
+    if (identity.hasLuid)
+        append("luid=" + FormatBytes(identity.luid, sizeof(identity.luid)));
+    return key;
+}
+
+inline bool ParseBytes(const std::string& text, uint8_t* bytes, size_t size) {
+    if (text.size() != size * 2)
+        return false;
+
+    for (size_t i = 0; i < size; ++i) {
+        unsigned int value = 0;
+        if (std::sscanf(text.c_str() + i * 2, "%2x", &value) != 1)
+            return false;
+        bytes[i] = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+// FormatDeviceKey 的逆操作，用于读取其他工具输出的 Device Key；遇到无法识别的字段时返回 false
+inline bool ParseDeviceKey(const std::string& key, GpuDeviceIdentity& identity) {
+    size_t begin = 0;
+    while (begin < key.size()) {
+        size_t end = key.find(' ', begin);
+        if (end == std::string::npos)
+            end = key.size();
+        std::string field = key.substr(begin, end - begin);
+        begin = end + 1;
+        if (field.empty())
+            continue;
+
+        size_t separator = field.find('=');
+        if (separator == std::string::npos)
+            return false;
+        std::string name = field.substr(0, separator);
+        std::string value = field.substr(separator + 1);
+
+        if (name == "id") {
+            unsigned int vendorId = 0, deviceId = 0;
+            int count = std::sscanf(value.c_str(), "%x:%x", &vendorId, &deviceId);
+            if (count < 1)
+                return false;
+            identity.vendorId = vendorId;
+            identity.deviceId = count == 2 ? deviceId : 0;
+        }
+        else if (name == "pci") {
+            if (!ParsePciAddress(value, identity))
+                return false;
+        }
+        else if (name == "uuid") {
+            if (!ParseBytes(value, identity.uuid, sizeof(identity.uuid)))
+                return false;
+            identity.hasUuid = true;
+        }
+        else if (name == "luid") {
+            if (!ParseBytes(value, identity.luid, sizeof(identity.luid)))
+                return false;
+            identity.hasLuid = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// LUID 与 UUID 由驱动生成，比 PCI 地址更可靠；都不可用时才退化到型号比较
+inline GpuMatchStrength MatchDevices(const GpuDeviceIdentity& a, const GpuDeviceIdentity& b) {
+    if (a.hasLuid && b.hasLuid)
+        return std::memcmp(a.luid, b.luid, sizeof(a.luid)) == 0 ? GpuMatchStrength::Luid : GpuMatchStrength::None;
+
+    if (a.hasUuid && b.hasUuid)
+        return std::memcmp(a.uuid, b.uuid, sizeof(a.uuid)) == 0 ? GpuMatchStrength::Uuid : GpuMatchStrength::None;
+
+    if (a.hasPciAddress && b.hasPciAddress) {
+        bool same = a.pciDomain == b.pciDomain && a.pciBus == b.pciBus
+            && a.pciDevice == b.pciDevice && a.pciFunction == b.pciFunction;
+        return same ? GpuMatchStrength::PciAddress : GpuMatchStrength::None;
+    }
+
+    if (a.vendorId != 0 && a.vendorId == b.vendorId && a.deviceId == b.deviceId)
+        return GpuMatchStrength::VendorDevice;
+
+    return GpuMatchStrength::None;
+}
+
+// 为 devices 中的每个设备在 others 中寻找对应项，找不到或仅凭型号无法唯一确定时为 -1
+inline std::vector<int> CorrelateDevices(const std::vector<GpuDeviceIdentity>& devices, const std::vector<GpuDeviceIdentity>& others) {
+    std::vector<int> result(devices.size(), -1);
+    for (size_t i = 0; i < devices.size(); ++i) {
+        GpuMatchStrength best = GpuMatchStrength::None;
+        int bestIndex = -1;
+        bool ambiguous = false;
+
+        for (size_t j = 0; j < others.size(); ++j) {
+            GpuMatchStrength strength = MatchDevices(devices[i], others[j]);
+            if (strength > best) {
+                best = strength;
+                bestIndex = static_cast<int>(j);
+                ambiguous = false;
+            }
+            else if (strength == best && strength != GpuMatchStrength::None) {
+                ambiguous = true;
+            }
+        }
+
+        if (!ambiguous)
+            result[i] = bestIndex;
+    }
+    return result;
+}
+
+// 用 source 中 target 缺少的字段补全 target，例如 OpenGL 设备通过 UUID 关联到 Vulkan 设备后获得 PCI 地址
+inline void MergeDeviceIdentity(GpuDeviceIdentity& target, const GpuDeviceIdentity& source) {
+    if (target.deviceId == 0 && source.deviceId != 0 && (target.vendorId == 0 || target.vendorId == source.vendorId)) {
+        target.vendorId = source.vendorId;
+        target.deviceId = source.deviceId;
+    }
+    if (!target.hasUuid && source.hasUuid) {
+        target.hasUuid = true;
+        std::memcpy(target.uuid, source.uuid, sizeof(target.uuid));
+    }
+    if (!target.hasLuid && source.hasLuid) {
+        target.hasLuid = true;
+        std::memcpy(target.luid, source.luid, sizeof(target.luid));
+    }
+    if (!target.hasPciAddress && source.hasPciAddress) {
+        target.hasPciAddress = true;
+        target.pciDomain = source.pciDomain;
+        target.pciBus = source.pciBus;
+        target.pciDevice = source.pciDevice;
+        target.pciFunction = source.pciFunction;
+    }
+}
+
+enum class GpuDeviceKind {
+    Other,
+    Cpu,        // lavapipe、WARP 等软件实现
+    Virtual,
+    Integrated,
+    Discrete,
+};
+
+struct GpuDeviceCandidate {
+    GpuDeviceIdentity identity;
+    GpuDeviceKind kind = GpuDeviceKind::Other;
+    uint64_t deviceLocalBytes = 0;      // 最大的 device local 堆
+    uint32_t graphicsQueueFamilies = 0;
+    uint32_t computeOnlyQueueFamilies = 0;
+    uint32_t transferOnlyQueueFamilies = 0;
+    double measuredThroughput = 0.0;    // 可选的实测吞吐（单位由调用方决定），0 表示未测
+};
+
+// 设备类型优先，其次是显存大小，最后是独立的异步计算/传输队列族
+inline double ScoreDevice(const GpuDeviceCandidate& candidate) {
+    double score = static_cast<double>(candidate.kind) * 1.0e6;
+    score += static_cast<double>(candidate.deviceLocalBytes / (1024 * 1024));
+    score += (candidate.graphicsQueueFamilies > 0 ? 1.0 : 0.0) * 100.0;
+    score += (candidate.computeOnlyQueueFamilies > 0 ? 1.0 : 0.0) * 10.0;
+    score += (candidate.transferOnlyQueueFamilies > 0 ? 1.0 : 0.0) * 1.0;
+    return score;
+}
+
+// 返回按优先级降序排列的下标。设备类型始终优先，避免 lavapipe 之类的软件实现凭实测吞吐排到真实 GPU 之前；
+// 同一类型内只有该类型的所有设备都有实测吞吐时才按吞吐排序，否则按 ScoreDevice 排序；
+// 仍相同时按 PCI 地址、UUID、原始下标决胜，保证结果稳定
+inline std::vector<size_t> RankDevices(const std::vector<GpuDeviceCandidate>& candidates) {
+    auto allMeasured = [&](GpuDeviceKind kind) {
+        return std::all_of(candidates.begin(), candidates.end(), [kind](const GpuDeviceCandidate& candidate) {
+            return candidate.kind != kind || candidate.measuredThroughput > 0.0;
+        });
+    };
+
+    auto primaryKey = [&](const GpuDeviceCandidate& candidate) {
+        double value = allMeasured(candidate.kind) ? candidate.measuredThroughput : ScoreDevice(candidate);
+        return std::make_pair(static_cast<int>(candidate.kind), value);
+    };
+    auto tieBreakKey = [](const GpuDeviceCandidate& candidate) {
+        const GpuDeviceIdentity& id = candidate.identity;
+        return std::make_tuple(!id.hasPciAddress, id.pciDomain, id.pciBus, id.pciDevice, id.pciFunction,
+            FormatBytes(id.uuid, sizeof(id.uuid)));
+    };
+
+    std::vector<size_t> order(candidates.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        auto keyA = primaryKey(candidates[a]);
+        auto keyB = primaryKey(candidates[b]);
+        if (keyA != keyB)
+            return keyA > keyB;
+        return tieBreakKey(candidates[a]) < tieBreakKey(candidates[b]);
+    });
+    return order;
+}
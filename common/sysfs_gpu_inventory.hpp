@@ -0,0 +1,225 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/utsname.h>
+
+#include "gpu_device_selection.hpp"
+
+// 通过 Linux sysfs 枚举 GPU（class/drm 与 bus/pci/devices），不依赖任何图形 API，
+// 可以发现没有加载驱动的设备，并补充 PCIe 链路、NUMA 节点、驱动版本等图形 API 不提供的信息。
+// 仅适用于 Linux。
+
+struct PciGpuInfo {
+    std::string pciAddress;     // 0000:01:00.0
+    std::string drmCard;        // card0，未绑定 DRM 驱动时为空
+    unsigned int vendorId = 0;
+    unsigned int deviceId = 0;
+    std::string driverName;
+    std::string driverVersion;
+    std::string driverVersionSource;    // module：模块版本；kernel：内置于内核的驱动，使用内核版本
+    uint64_t vramBytes = 0;     // 仅在驱动导出显存大小时有效
+    uint64_t barBytes = 0;      // 最大的可预取 BAR，即 CPU 可见的显存窗口，不等于显存大小
+    std::string currentLinkSpeed;
+    std::string maxLinkSpeed;
+    int currentLinkWidth = 0;
+    int maxLinkWidth = 0;
+    int numaNode = -1;
+};
+
+inline std::string ReadSysfsString(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    std::string value;
+    std::getline(file, value);
+    while (!value.empty() && (value.back() == '\n' || value.back() == ' ' || value.back() == '\r'))
+        value.pop_back();
+    return value;
+}
+
+inline uint64_t ReadSysfsNumber(const std::filesystem::path& path, uint64_t fallback = 0) {
+    std::string value = ReadSysfsString(path);
+    if (value.empty())
+        return fallback;
+    return std::strtoull(value.c_str(), nullptr, 0);
+}
+
+inline int ReadSysfsInt(const std::filesystem::path& path, int fallback) {
+    std::string value = ReadSysfsString(path);
+    if (value.empty())
+        return fallback;
+    return std::atoi(value.c_str());
+}
+
+// 从 uevent 中读取 KEY=VALUE 形式的字段
+inline std::string ReadUeventField(const std::filesystem::path& devicePath, const std::string& key) {
+    std::ifstream file(devicePath / "uevent");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, key.size() + 1, key + "=") == 0)
+            return line.substr(key.size() + 1);
+    }
+    return {};
+}
+
+// 解析 PCIe 速率字符串，例如 "16.0 GT/s PCIe"
+inline double ParseLinkSpeed(const std::string& speed) {
+    return std::strtod(speed.c_str(), nullptr);
+}
+
+inline std::string GetPciAddress(const std::filesystem::path& devicePath) {
+    std::string address = ReadUeventField(devicePath, "PCI_SLOT_NAME");
+    if (!address.empty())
+        return address;
+
+    std::error_code ec;
+    std::filesystem::path resolved = std::filesystem::canonical(devicePath, ec);
+    return ec ? std::string() : resolved.filename().string();
+}
+
+// 读取驱动名称与版本。amdgpu、i915、nouveau 等内核树内的驱动没有 version 文件，其版本即内核版本
+inline void ReadDriverInfo(const std::filesystem::path& sysfsRoot, const std::string& kernelRelease, const std::filesystem::path& devicePath, PciGpuInfo& info) {
+    std::error_code ec;
+    std::filesystem::path driverLink = std::filesystem::read_symlink(devicePath / "driver", ec);
+    info.driverName = ec ? ReadUeventField(devicePath, "DRIVER") : driverLink.filename().string();
+    if (info.driverName.empty())
+        return;
+
+    info.driverVersion = ReadSysfsString(sysfsRoot / "module" / info.driverName / "version");
+    if (!info.driverVersion.empty()) {
+        info.driverVersionSource = "module";
+    }
+    else if (!kernelRelease.empty()) {
+        info.driverVersion = kernelRelease;
+        info.driverVersionSource = "kernel";
+    }
+}
+
+// 目前只有 amdgpu 导出显存大小；其余驱动只记录最大的可预取 BAR。
+// 未开启 Resizable BAR 的 NVIDIA 卡上它只是 256 MB 的 BAR1 窗口，Intel 集显上则是 GTT 窗口，都不是显存
+inline void ReadMemorySizes(const std::filesystem::path& devicePath, PciGpuInfo& info) {
+    info.vramBytes = ReadSysfsNumber(devicePath / "mem_info_vram_total");
+
+    const uint64_t IORESOURCE_MEM = 0x00000200;
+    const uint64_t IORESOURCE_PREFETCH = 0x00002000;
+
+    std::ifstream file(devicePath / "resource");
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        uint64_t start = 0, end = 0, flags = 0;
+        stream >> std::hex >> start >> end >> flags;
+        if (!stream || end <= start)
+            continue;
+        if ((flags & IORESOURCE_MEM) && (flags & IORESOURCE_PREFETCH) && end - start + 1 > info.barBytes)
+            info.barBytes = end - start + 1;
+    }
+}
+
+inline PciGpuInfo ReadPciGpuInfo(const std::filesystem::path& sysfsRoot, const std::string& kernelRelease, const std::filesystem::path& devicePath) {
+    PciGpuInfo info;
+    info.pciAddress = GetPciAddress(devicePath);
+    info.vendorId = static_cast<unsigned int>(ReadSysfsNumber(devicePath / "vendor"));
+    info.deviceId = static_cast<unsigned int>(ReadSysfsNumber(devicePath / "device"));
+
+    ReadDriverInfo(sysfsRoot, kernelRelease, devicePath, info);
+    ReadMemorySizes(devicePath, info);
+
+    // 当前链路低于最大值时，可能是显卡没插好或插在了低速插槽上
+    info.currentLinkSpeed = ReadSysfsString(devicePath / "current_link_speed");
+    info.maxLinkSpeed = ReadSysfsString(devicePath / "max_link_speed");
+    info.currentLinkWidth = ReadSysfsInt(devicePath / "current_link_width", 0);
+    info.maxLinkWidth = ReadSysfsInt(devicePath / "max_link_width", 0);
+
+    info.numaNode = ReadSysfsInt(devicePath / "numa_node", -1);
+    return info;
+}
+
+// 枚举 class/drm 下的 cardN，返回 PCI 地址到 card 名称的映射
+inline std::map<std::string, std::string> EnumerateDrmCards(const std::filesystem::path& sysfsRoot) {
+    std::map<std::string, std::string> cards;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(sysfsRoot / "class" / "drm", ec)) {
+        std::string name = entry.path().filename().string();
+        // 跳过 card0-HDMI-A-1 之类的连接器节点以及 renderD128
+        if (name.compare(0, 4, "card") != 0 || name.find('-') != std::string::npos)
+            continue;
+
+        std::filesystem::path devicePath = entry.path() / "device";
+        if (!std::filesystem::exists(devicePath))
+            continue;
+
+        std::string address = GetPciAddress(devicePath);
+        if (!address.empty())
+            cards.emplace(address, name);
+    }
+    return cards;
+}
+
+// 枚举 bus/pci/devices 下的显示控制器（class 0x03xxxx），可以发现没有绑定 DRM 驱动的 GPU
+inline std::map<std::string, std::filesystem::path> EnumeratePciDisplayDevices(const std::filesystem::path& sysfsRoot) {
+    std::map<std::string, std::filesystem::path> devices;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(sysfsRoot / "bus" / "pci" / "devices", ec)) {
+        uint64_t pciClass = ReadSysfsNumber(entry.path() / "class");
+        if ((pciClass >> 16) != 0x03)
+            continue;
+
+        devices.emplace(entry.path().filename().string(), entry.path());
+    }
+    return devices;
+}
+
+inline std::vector<PciGpuInfo> GetSysfsGpuInfo(const std::filesystem::path& sysfsRoot) {
+    // DRM 与 PCI 两棵树并行枚举
+    auto drmFuture = std::async(std::launch::async, EnumerateDrmCards, sysfsRoot);
+    auto pciFuture = std::async(std::launch::async, EnumeratePciDisplayDevices, sysfsRoot);
+    std::map<std::string, std::string> drmCards = drmFuture.get();
+    std::map<std::string, std::filesystem::path> pciDevices = pciFuture.get();
+
+    // 只在 DRM 中出现的设备（例如非 PCI 的 SoC GPU）也需要收集
+    for (const auto& card : drmCards) {
+        if (pciDevices.find(card.first) == pciDevices.end())
+            pciDevices.emplace(card.first, sysfsRoot / "class" / "drm" / card.second / "device");
+    }
+
+    // 只有读取本机 sysfs 时内核版本才有意义，伪造的目录树不使用宿主机的内核版本
+    std::string kernelRelease;
+    std::error_code ec;
+    struct utsname systemName;
+    if (std::filesystem::equivalent(sysfsRoot, "/sys", ec) && uname(&systemName) == 0)
+        kernelRelease = systemName.release;
+
+    // 每个设备的属性读取相互独立，同样并行进行
+    std::vector<std::future<PciGpuInfo>> futures;
+    for (const auto& device : pciDevices)
+        futures.push_back(std::async(std::launch::async, ReadPciGpuInfo, sysfsRoot, kernelRelease, device.second));
+
+    std::vector<PciGpuInfo> gpus;
+    for (auto& future : futures) {
+        PciGpuInfo info = future.get();
+        auto card = drmCards.find(info.pciAddress);
+        if (card != drmCards.end())
+            info.drmCard = card->second;
+        gpus.push_back(std::move(info));
+    }
+    return gpus;
+}
+
+// 转换为与其他 API 比较用的标识，sysfs 只能提供型号与 PCI 地址
+inline GpuDeviceIdentity GetSysfsIdentity(const PciGpuInfo& info) {
+    GpuDeviceIdentity identity;
+    identity.api = "PCI";
+    identity.name = info.drmCard.empty() ? info.pciAddress : info.drmCard;
+    identity.vendorId = info.vendorId;
+    identity.deviceId = info.deviceId;
+    ParsePciAddress(info.pciAddress, identity);
+    return identity;
+}
@@ -1,10 +1,13 @@
-﻿#include <iostream>
+﻿#include <cstring>
+#include <iostream>
+#include <vector>
 
 #include <d3d12.h>
 #include <dxgi1_4.h>
 #include <wrl.h>
 
 #include "magic_enum.hpp"
+#include "../common/gpu_device_selection.hpp"
 
 #pragma comment(lib, "D3D12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -84,21 +87,60 @@ int main() {
         return -1;
     }
 
-    // 获取适配器（GPU）
-    ComPtr<IDXGIAdapter1> hardwareAdapter;
-    for (UINT adapterIndex = 0; dxgiFactory->EnumAdapters1(adapterIndex, &hardwareAdapter) != DXGI_ERROR_NOT_FOUND; ++adapterIndex) {
+    // 枚举所有适配器（GPU）并打分，选择得分最高的适配器，避免在多 GPU 机器上选中集显
+    std::vector<ComPtr<IDXGIAdapter1>> adapters;
+    std::vector<GpuDeviceCandidate> candidates;
+    ComPtr<IDXGIAdapter1> adapter;
+    for (UINT adapterIndex = 0; dxgiFactory->EnumAdapters1(adapterIndex, &adapter) != DXGI_ERROR_NOT_FOUND; ++adapterIndex) {
         DXGI_ADAPTER_DESC1 desc;
-        hardwareAdapter->GetDesc1(&desc);
-
-        // 检查是否为软件设备
+        adapter->GetDesc1(&desc);
+
+        GpuDeviceCandidate candidate;
+        candidate.identity.api = "DXGI";
+        char name[128] = {};
+        WideCharToMultiByte(CP_UTF8, 0, desc.Description, -1, name, sizeof(name) - 1, nullptr, nullptr);
+        candidate.identity.name = name;
+        candidate.identity.vendorId = desc.VendorId;
+        candidate.identity.deviceId = desc.DeviceId;
+        candidate.identity.hasLuid = true;
+        std::memcpy(candidate.identity.luid, &desc.AdapterLuid, sizeof(candidate.identity.luid));
+        candidate.deviceLocalBytes = desc.DedicatedVideoMemory;
+
+        // 软件设备（WARP）排在最后；硬件设备通过 UMA 区分集显与独显
         if (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) {
-            continue; // 跳过软件设备
+            candidate.kind = GpuDeviceKind::Cpu;
         }
+        else {
+            ComPtr<ID3D12Device> probeDevice;
+            if (FAILED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&probeDevice))))
+                continue;
+
+            D3D12_FEATURE_DATA_ARCHITECTURE architecture = {};
+            probeDevice->CheckFeatureSupport(D3D12_FEATURE_ARCHITECTURE, &architecture, sizeof(architecture));
+            candidate.kind = architecture.UMA ? GpuDeviceKind::Integrated : GpuDeviceKind::Discrete;
+        }
+
+        adapters.push_back(adapter);
+        candidates.push_back(candidate);
+    }
 
-        std::wcout << L"Using Adapter: " << desc.Description << std::endl;
-        break;
+    if (adapters.empty()) {
+        std::cerr << "Failed to find a D3D12 capable adapter." << std::endl;
+        return -1;
     }
 
+    std::vector<size_t> ranking = RankDevices(candidates);
+    std::cout << "Adapter Ranking: " << std::endl;
+    for (size_t rank = 0; rank < ranking.size(); ++rank) {
+        const GpuDeviceCandidate& candidate = candidates[ranking[rank]];
+        std::cout << "\t" << rank << ": " << candidate.identity.name
+            << " (" << magic_enum::enum_name(candidate.kind) << ", score " << ScoreDevice(candidate) << ")" << std::endl;
+        std::cout << "\t\tDevice Key: " << FormatDeviceKey(candidate.identity) << std::endl;
+    }
+
+    ComPtr<IDXGIAdapter1> hardwareAdapter = adapters[ranking[0]];
+    std::cout << "Using Adapter: " << candidates[ranking[0]].identity.name << std::endl;
+
     // 创建 D3D12 设备
     ComPtr<ID3D12Device> device;
     hr = D3D12CreateDevice(
@@ -1,4 +1,6 @@
 ﻿#include <iostream>
+
+#ifdef _WIN32
 #include <comdef.h>
 #include <wbemidl.h>
 
@@ -96,9 +98,152 @@ void GetVideoControllerInfo() {
     CoUninitialize();
 }
 
-int main() {
+
+#else
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../common/gpu_device_selection.hpp"
+#include "../common/sysfs_gpu_inventory.hpp"
+
+static const char* GetVendorName(unsigned int vendorId) {
+    switch (vendorId) {
+    case 0x10de: return "NVIDIA";
+    case 0x1002: return "AMD";
+    case 0x8086: return "Intel";
+    case 0x13b5: return "ARM";
+    case 0x5143: return "Qualcomm";
+    case 0x1af4: return "Virtio";
+    case 0x15ad: return "VMware";
+    case 0x1234: return "QEMU";
+    default: return "Unknown";
+    }
+}
+
+void PrintSysfsGpuInfo(const std::vector<PciGpuInfo>& gpus) {
+    if (gpus.empty()) {
+        std::cerr << "Failed to find any GPU in sysfs." << std::endl;
+        return;
+    }
+
+    for (const auto& gpu : gpus) {
+        std::cout << "PCI Address: " << gpu.pciAddress << std::endl;
+        std::cout << "\tDRM Card: " << (gpu.drmCard.empty() ? "none" : gpu.drmCard) << std::endl;
+        std::cout << "\tVendor: " << GetVendorName(gpu.vendorId) << std::hex
+            << " (0x" << gpu.vendorId << ")" << std::endl;
+        std::cout << "\tDevice ID: 0x" << gpu.deviceId << std::dec << std::endl;
+        std::cout << "\tDriver: " << (gpu.driverName.empty() ? "none" : gpu.driverName) << std::endl;
+        if (gpu.driverVersion.empty())
+            std::cout << "\tDriver Version: unknown" << std::endl;
+        else
+            std::cout << "\tDriver Version: " << gpu.driverVersion << " (" << gpu.driverVersionSource << ")" << std::endl;
+
+        if (gpu.vramBytes != 0)
+            std::cout << "\tVRAM: " << gpu.vramBytes / (1024 * 1024) << " MB" << std::endl;
+        else
+            std::cout << "\tVRAM: unknown" << std::endl;
+
+        if (gpu.barBytes != 0)
+            std::cout << "\tBAR Size: " << gpu.barBytes / (1024 * 1024) << " MB" << std::endl;
+
+        if (!gpu.maxLinkSpeed.empty()) {
+            std::cout << "\tPCIe Link: " << gpu.currentLinkSpeed << " x" << gpu.currentLinkWidth
+                << " (max " << gpu.maxLinkSpeed << " x" << gpu.maxLinkWidth << ")" << std::endl;
+
+            // 部分 GPU 空闲时会主动降速，需要在负载下复查
+            if (ParseLinkSpeed(gpu.currentLinkSpeed) < ParseLinkSpeed(gpu.maxLinkSpeed) || gpu.currentLinkWidth < gpu.maxLinkWidth)
+                std::cout << "\tWarning: PCIe link is running below its maximum (idle power saving or misseated card)" << std::endl;
+        }
+
+        std::cout << "\tNUMA Node: " << gpu.numaNode << std::endl;
+
+        // 与 vulkan_feature_check 等工具输出的 Device Key 对应
+        std::cout << "\tDevice Key: " << FormatDeviceKey(GetSysfsIdentity(gpu)) << std::endl;
+    }
+}
+
+// 读取其他工具输出中的 "Device Key:" 行，并找出每一行对应的 sysfs 设备。
+// OpenGL 只提供 UUID，先通过同一输入中 Vulkan 的 UUID/LUID 取得 PCI 地址，再与 sysfs 比较
+void CorrelateDeviceKeys(std::istream& input, const std::vector<PciGpuInfo>& gpus) {
+    const std::string marker = "Device Key: ";
+    std::vector<std::string> keys;
+    std::vector<GpuDeviceIdentity> identities;
+
+    std::string line;
+    while (std::getline(input, line)) {
+        size_t position = line.find(marker);
+        if (position == std::string::npos)
+            continue;
+
+        std::string key = line.substr(position + marker.size());
+        while (!key.empty() && (key.back() == '\r' || key.back() == ' '))
+            key.pop_back();
+
+        GpuDeviceIdentity identity;
+        if (!ParseDeviceKey(key, identity)) {
+            std::cerr << "Ignoring malformed Device Key: " << key << std::endl;
+            continue;
+        }
+        keys.push_back(key);
+        identities.push_back(identity);
+    }
+
+    std::vector<GpuDeviceIdentity> merged = identities;
+    for (size_t i = 0; i < merged.size(); ++i) {
+        for (size_t j = 0; j < identities.size(); ++j) {
+            if (i != j && MatchDevices(merged[i], identities[j]) >= GpuMatchStrength::Uuid)
+                MergeDeviceIdentity(merged[i], identities[j]);
+        }
+    }
+
+    std::vector<GpuDeviceIdentity> sysfsIdentities;
+    for (const auto& gpu : gpus)
+        sysfsIdentities.push_back(GetSysfsIdentity(gpu));
+    std::vector<int> matches = CorrelateDevices(merged, sysfsIdentities);
+
+    std::cout << "Device Key Correlation: " << std::endl;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        std::cout << "\t" << keys[i] << std::endl;
+        if (matches[i] < 0) {
+            std::cout << "\t\t-> no unique sysfs device" << std::endl;
+            continue;
+        }
+
+        const PciGpuInfo& gpu = gpus[matches[i]];
+        std::cout << "\t\t-> " << gpu.pciAddress << " (" << (gpu.drmCard.empty() ? "no DRM card" : gpu.drmCard)
+            << ", driver " << (gpu.driverName.empty() ? "none" : gpu.driverName) << ", NUMA node " << gpu.numaNode << ")" << std::endl;
+    }
+}
+
+#endif
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
     GetVideoControllerInfo();
 
     system("pause");
+#else
+    // 可通过第一个参数指定 sysfs 根目录，便于在没有 GPU 的环境下用伪造的目录树测试；
+    // 第二个参数为包含 Device Key 的文件（"-" 表示标准输入），例如 vulkan_feature_check 的输出
+    const char* sysfsRoot = argc > 1 ? argv[1] : "/sys";
+    std::vector<PciGpuInfo> gpus = GetSysfsGpuInfo(sysfsRoot);
+    PrintSysfsGpuInfo(gpus);
+
+    if (argc > 2) {
+        if (std::string(argv[2]) == "-") {
+            CorrelateDeviceKeys(std::cin, gpus);
+        }
+        else {
+            std::ifstream file(argv[2]);
+            if (!file) {
+                std::cerr << "Failed to open " << argv[2] << std::endl;
+                return -1;
+            }
+            CorrelateDeviceKeys(file, gpus);
+        }
+    }
+#endif
     return 0;
-}
\ No newline at end of file
+}
@@ -1,11 +1,20 @@
 ﻿#include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
+#include <string>
+#include <vector>
+
+#include "../common/gl_program_binary_cache.hpp"
+#include "../common/gpu_device_selection.hpp"
 
 const unsigned int SCR_WIDTH = 400;
 const unsigned int SCR_HEIGHT = 300;
 
 static void APIENTRY gl_debug_output(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
+static void check_program_binary();
+static uint32_t gl_vendor_id(const char* vendor);
 
 int main()
 {
@@ -54,6 +63,32 @@ int main()
         std::cout << "Unknown Profile" << std::endl;
     }
 
+    // GL 无法自行选择设备，通过 GL_EXT_memory_object 查询设备 UUID，与 Vulkan 的 deviceUUID 对应后即可确认实际使用的 GPU
+    if (GLAD_GL_EXT_memory_object) {
+        GLint numDeviceUuids = 0;
+        glGetIntegerv(GL_NUM_DEVICE_UUIDS_EXT, &numDeviceUuids);
+
+        for (GLint i = 0; i < numDeviceUuids; i++) {
+            GpuDeviceIdentity identity;
+            identity.api = "OpenGL";
+            identity.name = reinterpret_cast<const char*>(renderer);
+            identity.vendorId = gl_vendor_id(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+            identity.hasUuid = true;
+            glGetUnsignedBytei_vEXT(GL_DEVICE_UUID_EXT, i, identity.uuid);
+
+            // LUID 描述的是整个上下文所在的设备，只有单设备时才能对应到具体 UUID
+            if (GLAD_GL_EXT_memory_object_win32 && numDeviceUuids == 1) {
+                identity.hasLuid = true;
+                glGetUnsignedBytevEXT(GL_DEVICE_LUID_EXT, identity.luid);
+            }
+
+            std::cout << "Device Key: " << FormatDeviceKey(identity) << std::endl;
+        }
+    }
+    else {
+        std::cout << "GL_EXT_memory_object not supported, device UUID unavailable" << std::endl;
+    }
+
     auto extensions = glGetString(GL_EXTENSIONS);
     if (extensions)
         std::cout << extensions << std::endl;
@@ -90,6 +125,8 @@ int main()
 
     glDeleteTextures(1, &texture);
 
+    check_program_binary();
+
     // glfw: terminate, clearing all previously allocated GLFWresources.
     glfwTerminate();
 
@@ -97,6 +134,317 @@ int main()
     return 0;
 }
 
+struct ProbeProgram {
+    const char* name;
+    const char* vertexSource;
+    const char* fragmentSource;
+};
+
+// 代表性的程序集合：从最简单的直通着色器到带循环的多光源着色
+static const ProbeProgram probe_programs[] = {
+    {
+        "passthrough",
+        "layout(location = 0) in vec3 aPos;\n"
+        "uniform mat4 uMVP;\n"
+        "void main() { gl_Position = uMVP * vec4(aPos, 1.0); }\n",
+        "out vec4 FragColor;\n"
+        "uniform vec4 uColor;\n"
+        "void main() { FragColor = uColor; }\n"
+    },
+    {
+        "textured_blinn_phong",
+        "layout(location = 0) in vec3 aPos;\n"
+        "layout(location = 1) in vec3 aNormal;\n"
+        "layout(location = 2) in vec2 aUV;\n"
+        "uniform mat4 uModel;\n"
+        "uniform mat4 uViewProj;\n"
+        "out vec3 vWorldPos;\n"
+        "out vec3 vNormal;\n"
+        "out vec2 vUV;\n"
+        "void main() {\n"
+        "    vec4 world = uModel * vec4(aPos, 1.0);\n"
+        "    vWorldPos = world.xyz;\n"
+        "    vNormal = mat3(transpose(inverse(uModel))) * aNormal;\n"
+        "    vUV = aUV;\n"
+        "    gl_Position = uViewProj * world;\n"
+        "}\n",
+        "in vec3 vWorldPos;\n"
+        "in vec3 vNormal;\n"
+        "in vec2 vUV;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D uAlbedo;\n"
+        "uniform vec3 uLightPos;\n"
+        "uniform vec3 uViewPos;\n"
+        "void main() {\n"
+        "    vec3 albedo = texture(uAlbedo, vUV).rgb;\n"
+        "    vec3 n = normalize(vNormal);\n"
+        "    vec3 l = normalize(uLightPos - vWorldPos);\n"
+        "    vec3 h = normalize(l + normalize(uViewPos - vWorldPos));\n"
+        "    float diffuse = max(dot(n, l), 0.0);\n"
+        "    float specular = pow(max(dot(n, h), 0.0), 32.0);\n"
+        "    FragColor = vec4(albedo * (0.1 + diffuse) + vec3(specular), 1.0);\n"
+        "}\n"
+    },
+    {
+        "pbr_multi_light",
+        "layout(location = 0) in vec3 aPos;\n"
+        "layout(location = 1) in vec3 aNormal;\n"
+        "layout(location = 2) in vec4 aTangent;\n"
+        "layout(location = 3) in vec2 aUV;\n"
+        "uniform mat4 uModel;\n"
+        "uniform mat4 uViewProj;\n"
+        "out vec3 vWorldPos;\n"
+        "out mat3 vTBN;\n"
+        "out vec2 vUV;\n"
+        "void main() {\n"
+        "    vec4 world = uModel * vec4(aPos, 1.0);\n"
+        "    vec3 n = normalize(mat3(uModel) * aNormal);\n"
+        "    vec3 t = normalize(mat3(uModel) * aTangent.xyz);\n"
+        "    vTBN = mat3(t, cross(n, t) * aTangent.w, n);\n"
+        "    vWorldPos = world.xyz;\n"
+        "    vUV = aUV;\n"
+        "    gl_Position = uViewProj * world;\n"
+        "}\n",
+        "#define LIGHT_COUNT 16\n"
+        "in vec3 vWorldPos;\n"
+        "in mat3 vTBN;\n"
+        "in vec2 vUV;\n"
+        "out vec4 FragColor;\n"
+        "uniform sampler2D uAlbedo;\n"
+        "uniform sampler2D uNormal;\n"
+        "uniform sampler2D uMetalRough;\n"
+        "uniform vec3 uViewPos;\n"
+        "uniform vec4 uLightPosRadius[LIGHT_COUNT];\n"
+        "uniform vec3 uLightColor[LIGHT_COUNT];\n"
+        "const float PI = 3.14159265;\n"
+        "float distribution_ggx(float NdotH, float roughness) {\n"
+        "    float a2 = roughness * roughness * roughness * roughness;\n"
+        "    float d = NdotH * NdotH * (a2 - 1.0) + 1.0;\n"
+        "    return a2 / (PI * d * d);\n"
+        "}\n"
+        "float geometry_smith(float NdotV, float NdotL, float roughness) {\n"
+        "    float k = (roughness + 1.0) * (roughness + 1.0) / 8.0;\n"
+        "    return (NdotV / (NdotV * (1.0 - k) + k)) * (NdotL / (NdotL * (1.0 - k) + k));\n"
+        "}\n"
+        "void main() {\n"
+        "    vec3 albedo = texture(uAlbedo, vUV).rgb;\n"
+        "    vec2 mr = texture(uMetalRough, vUV).bg;\n"
+        "    vec3 n = normalize(vTBN * (texture(uNormal, vUV).xyz * 2.0 - 1.0));\n"
+        "    vec3 v = normalize(uViewPos - vWorldPos);\n"
+        "    vec3 f0 = mix(vec3(0.04), albedo, mr.x);\n"
+        "    vec3 color = vec3(0.0);\n"
+        "    for (int i = 0; i < LIGHT_COUNT; ++i) {\n"
+        "        vec3 toLight = uLightPosRadius[i].xyz - vWorldPos;\n"
+        "        float dist = length(toLight);\n"
+        "        vec3 l = toLight / dist;\n"
+        "        vec3 h = normalize(v + l);\n"
+        "        float NdotL = max(dot(n, l), 0.0);\n"
+        "        float NdotV = max(dot(n, v), 1e-4);\n"
+        "        vec3 f = f0 + (1.0 - f0) * pow(1.0 - max(dot(h, v), 0.0), 5.0);\n"
+        "        float attenuation = clamp(1.0 - dist / uLightPosRadius[i].w, 0.0, 1.0);\n"
+        "        vec3 specular = distribution_ggx(max(dot(n, h), 0.0), mr.y) * geometry_smith(NdotV, NdotL, mr.y) * f / (4.0 * NdotV * NdotL + 1e-4);\n"
+        "        vec3 diffuse = (1.0 - f) * (1.0 - mr.x) * albedo / PI;\n"
+        "        color += (diffuse + specular) * uLightColor[i] * NdotL * attenuation * attenuation;\n"
+        "    }\n"
+        "    FragColor = vec4(color / (color + 1.0), 1.0);\n"
+        "}\n"
+    },
+};
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 在源码中加入随机盐值，绕过驱动自带的着色器磁盘缓存，测得的才是冷启动时间
+static std::string make_shader_source(const char* body, unsigned long long salt)
+{
+    return "#version 330 core\n#define PROBE_SALT " + std::to_string(salt) + "\n" + body;
+}
+
+static GLuint create_shader(GLenum type, const std::string& source)
+{
+    GLuint shader = glCreateShader(type);
+    const char* text = source.c_str();
+    glShaderSource(shader, 1, &text, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+static bool check_shader(GLuint shader)
+{
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        std::cout << "shader compile failed: " << log << std::endl;
+    }
+    return compiled == GL_TRUE;
+}
+
+static bool check_program(GLuint program)
+{
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        std::cout << "program link failed: " << log << std::endl;
+    }
+    return linked == GL_TRUE;
+}
+
+// 测量着色器编译、链接耗时，以及从程序二进制重新加载的耗时，用于判断该驱动是否值得预先分发程序二进制
+static void check_program_binary()
+{
+    const bool hasProgramBinary = GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary;
+    const bool hasParallelCompile = GLAD_GL_ARB_parallel_shader_compile || GLAD_GL_KHR_parallel_shader_compile;
+    std::cout << "GL_ARB_get_program_binary: " << hasProgramBinary << std::endl;
+    std::cout << "GL_ARB_parallel_shader_compile: " << hasParallelCompile << std::endl;
+
+    GLint numBinaryFormats = 0;
+    if (hasProgramBinary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+        std::vector<GLint> formats(numBinaryFormats);
+        if (numBinaryFormats > 0)
+            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+
+        std::cout << "GL_NUM_PROGRAM_BINARY_FORMATS: " << numBinaryFormats << std::endl;
+        for (GLint format : formats)
+            std::cout << "\tformat: 0x" << std::hex << format << std::dec << std::endl;
+    }
+
+    const unsigned long long salt = std::chrono::steady_clock::now().time_since_epoch().count();
+    // 缓存放在系统临时目录，不依赖当前工作目录是否可写
+    std::error_code ec;
+    std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path(ec);
+    if (ec)
+        cacheDirectory = ".";
+    GlProgramBinaryCache cache(cacheDirectory.string());
+    const bool useCache = hasProgramBinary && !cache.GetFormats().empty();
+    double totalCompileMs = 0.0, totalLinkMs = 0.0, totalReloadMs = 0.0;
+
+    for (const ProbeProgram& probe : probe_programs) {
+        std::string vertexSource = make_shader_source(probe.vertexSource, salt);
+        std::string fragmentSource = make_shader_source(probe.fragmentSource, salt);
+
+        // 查询编译状态会等待编译完成，因此计时包含驱动的全部编译工作
+        auto start = std::chrono::steady_clock::now();
+        GLuint vertexShader = create_shader(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragmentShader = create_shader(GL_FRAGMENT_SHADER, fragmentSource);
+        bool compiled = check_shader(vertexShader) && check_shader(fragmentShader);
+        double compileMs = elapsed_ms(start);
+
+        GLuint program = glCreateProgram();
+        if (useCache)
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+
+        start = std::chrono::steady_clock::now();
+        glLinkProgram(program);
+        bool linked = compiled && check_program(program);
+        double linkMs = elapsed_ms(start);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        std::cout << "Program " << probe.name << ": compile " << compileMs << " ms, link " << linkMs << " ms";
+        totalCompileMs += compileMs;
+        totalLinkMs += linkMs;
+
+        if (linked && useCache) {
+            std::string programKey = std::to_string(GlProgramBinaryCache::Hash(vertexSource.data(), vertexSource.size(),
+                GlProgramBinaryCache::Hash(fragmentSource.data(), fragmentSource.size())));
+
+            GLint binaryLength = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+            if (cache.Store(programKey, program)) {
+                GLuint reloaded = glCreateProgram();
+                start = std::chrono::steady_clock::now();
+                bool loaded = cache.Load(programKey, reloaded);
+                double reloadMs = elapsed_ms(start);
+                glDeleteProgram(reloaded);
+                cache.Invalidate(programKey);
+
+                if (loaded) {
+                    std::cout << ", binary " << binaryLength << " bytes, reload " << reloadMs << " ms";
+                    totalReloadMs += reloadMs;
+                }
+                else {
+                    std::cout << ", binary reload rejected by driver";
+                }
+            }
+            else {
+                std::cout << ", failed to store program binary";
+            }
+        }
+        std::cout << std::endl;
+
+        glDeleteProgram(program);
+    }
+
+    std::cout << "Total compile " << totalCompileMs << " ms, link " << totalLinkMs << " ms";
+    if (totalReloadMs > 0.0)
+        std::cout << ", binary reload " << totalReloadMs << " ms (" << (totalCompileMs + totalLinkMs) / totalReloadMs << "x faster)";
+    std::cout << std::endl;
+
+    // 并行编译：先提交全部编译与链接，再轮询 GL_COMPLETION_STATUS_ARB，对比串行总耗时
+    if (hasParallelCompile) {
+        if (GLAD_GL_ARB_parallel_shader_compile)
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        else
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+
+        GLint maxThreads = 0;
+        glGetIntegerv(GL_MAX_SHADER_COMPILER_THREADS_ARB, &maxThreads);
+        std::cout << "GL_MAX_SHADER_COMPILER_THREADS_ARB: " << maxThreads << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<GLuint> programs;
+        for (const ProbeProgram& probe : probe_programs) {
+            GLuint vertexShader = create_shader(GL_VERTEX_SHADER, make_shader_source(probe.vertexSource, salt + 1));
+            GLuint fragmentShader = create_shader(GL_FRAGMENT_SHADER, make_shader_source(probe.fragmentSource, salt + 1));
+            GLuint program = glCreateProgram();
+            glAttachShader(program, vertexShader);
+            glAttachShader(program, fragmentShader);
+            glLinkProgram(program);
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            programs.push_back(program);
+        }
+
+        for (GLuint program : programs) {
+            GLint completed = GL_FALSE;
+            while (!completed)
+                glGetProgramiv(program, GL_COMPLETION_STATUS_ARB, &completed);
+            check_program(program);
+            glDeleteProgram(program);
+        }
+
+        std::cout << "Parallel compile and link " << elapsed_ms(start) << " ms (serial " << totalCompileMs + totalLinkMs << " ms)" << std::endl;
+    }
+}
+
+// GL 不提供 PCI ID，只能从 GL_VENDOR 推断厂商；设备 ID 与 PCI 地址需通过 UUID 关联 Vulkan 设备获得。
+// Mesa 的软件实现（llvmpipe 等）返回 "Mesa"，不对应任何 PCI 厂商
+static uint32_t gl_vendor_id(const char* vendor)
+{
+    if (!vendor)
+        return 0;
+
+    std::string name = vendor;
+    if (name.find("NVIDIA") != std::string::npos || name.find("nouveau") != std::string::npos)
+        return 0x10de;
+    if (name.find("AMD") != std::string::npos || name.find("ATI") != std::string::npos)
+        return 0x1002;
+    if (name.find("Intel") != std::string::npos)
+        return 0x8086;
+    return 0;
+}
+
 static void APIENTRY gl_debug_output(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
 {
 
@@ -1,24 +1,871 @@
 ﻿#define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include <vulkan/vulkan.h>
+#include <shaderc/shaderc.hpp>
 
 #include "magic_enum.hpp"
+#include "../common/gpu_device_selection.hpp"
+#ifdef __linux__
+#include "../common/sysfs_gpu_inventory.hpp"
+#endif
 
-int main() {
-    // 初始化 GLFW 库
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
-        return -1;
+// VK_SUBGROUP_FEATURE_QUAD_BIT 为 0x80，超出 magic_enum 默认的 [-128, 127] 范围，按位标志反射才能取到名字
+template <>
+struct magic_enum::customize::enum_range<VkSubgroupFeatureFlagBits> {
+    static constexpr bool is_flags = true;
+};
+
+static bool HasDeviceExtension(VkPhysicalDevice physicalDevice, const char* extensionName) {
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, extensions.data());
+
+    for (const auto& ext : extensions) {
+        if (std::strcmp(ext.extensionName, extensionName) == 0)
+            return true;
+    }
+    return false;
+}
+
+// 收集设备标识（UUID/LUID/PCI 地址）以及用于排序的类型、显存与队列族信息
+static GpuDeviceCandidate DescribePhysicalDevice(VkPhysicalDevice physicalDevice) {
+    GpuDeviceCandidate candidate;
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    candidate.identity.api = "Vulkan";
+    candidate.identity.name = deviceProperties.deviceName;
+    candidate.identity.vendorId = deviceProperties.vendorID;
+    candidate.identity.deviceId = deviceProperties.deviceID;
+
+    switch (deviceProperties.deviceType) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: candidate.kind = GpuDeviceKind::Discrete; break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: candidate.kind = GpuDeviceKind::Integrated; break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: candidate.kind = GpuDeviceKind::Virtual; break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU: candidate.kind = GpuDeviceKind::Cpu; break;
+    default: candidate.kind = GpuDeviceKind::Other; break;
+    }
+
+    // deviceUUID/deviceLUID 为 Vulkan 1.1 核心功能，PCI 地址需要 VK_EXT_pci_bus_info
+    if (deviceProperties.apiVersion >= VK_API_VERSION_1_1) {
+        VkPhysicalDevicePCIBusInfoPropertiesEXT pciBusInfo{};
+        pciBusInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT;
+
+        VkPhysicalDeviceIDProperties idProperties{};
+        idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+        bool hasPciBusInfo = HasDeviceExtension(physicalDevice, VK_EXT_PCI_BUS_INFO_EXTENSION_NAME);
+        if (hasPciBusInfo)
+            idProperties.pNext = &pciBusInfo;
+
+        VkPhysicalDeviceProperties2 properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &idProperties;
+        vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+        candidate.identity.hasUuid = true;
+        std::memcpy(candidate.identity.uuid, idProperties.deviceUUID, VK_UUID_SIZE);
+
+        if (idProperties.deviceLUIDValid) {
+            candidate.identity.hasLuid = true;
+            std::memcpy(candidate.identity.luid, idProperties.deviceLUID, VK_LUID_SIZE);
+        }
+
+        if (hasPciBusInfo) {
+            candidate.identity.hasPciAddress = true;
+            candidate.identity.pciDomain = pciBusInfo.pciDomain;
+            candidate.identity.pciBus = pciBusInfo.pciBus;
+            candidate.identity.pciDevice = pciBusInfo.pciDevice;
+            candidate.identity.pciFunction = pciBusInfo.pciFunction;
+        }
+    }
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            candidate.deviceLocalBytes = std::max<uint64_t>(candidate.deviceLocalBytes, memoryProperties.memoryHeaps[i].size);
+    }
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    for (const auto& family : queueFamilies) {
+        if (family.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            candidate.graphicsQueueFamilies++;
+        else if (family.queueFlags & VK_QUEUE_COMPUTE_BIT)
+            candidate.computeOnlyQueueFamilies++;
+        else if (family.queueFlags & VK_QUEUE_TRANSFER_BIT)
+            candidate.transferOnlyQueueFamilies++;
+    }
+
+    return candidate;
+}
+
+struct SubgroupCapabilities {
+    bool vulkan11 = false;              // 设备支持 Vulkan 1.1，着色器按 SPIR-V 1.3 编译
+    uint32_t subgroupSize = 0;
+    VkShaderStageFlags supportedStages = 0;
+    VkSubgroupFeatureFlags supportedOperations = 0;
+
+    bool sizeControl = false;           // VK_EXT_subgroup_size_control 或 Vulkan 1.3
+    bool computeFullSubgroups = false;
+    uint32_t minSubgroupSize = 0;
+    uint32_t maxSubgroupSize = 0;
+    uint32_t maxComputeWorkgroupSubgroups = 0;
+    VkShaderStageFlags requiredSubgroupSizeStages = 0;
+
+    uint32_t maxComputeSharedMemorySize = 0;
+    uint32_t maxComputeWorkGroupInvocations = 0;
+    uint32_t maxComputeWorkGroupSize[3] = {};
+    uint32_t maxComputeWorkGroupCount = 0;
+    float timestampPeriod = 0.0f;
+    bool needsSizeControlExtension = false;
+};
+
+static SubgroupCapabilities QuerySubgroupCapabilities(VkPhysicalDevice physicalDevice) {
+    SubgroupCapabilities caps;
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    caps.maxComputeSharedMemorySize = deviceProperties.limits.maxComputeSharedMemorySize;
+    caps.maxComputeWorkGroupInvocations = deviceProperties.limits.maxComputeWorkGroupInvocations;
+    for (int i = 0; i < 3; i++)
+        caps.maxComputeWorkGroupSize[i] = deviceProperties.limits.maxComputeWorkGroupSize[i];
+    caps.maxComputeWorkGroupCount = deviceProperties.limits.maxComputeWorkGroupCount[0];
+    caps.timestampPeriod = deviceProperties.limits.timestampPeriod;
+
+    // 子组属性为 Vulkan 1.1 核心功能
+    if (deviceProperties.apiVersion < VK_API_VERSION_1_1)
+        return caps;
+    caps.vulkan11 = true;
+
+    bool coreSizeControl = deviceProperties.apiVersion >= VK_API_VERSION_1_3;
+    bool extSizeControl = HasDeviceExtension(physicalDevice, VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+
+    VkPhysicalDeviceSubgroupSizeControlProperties sizeControlProperties{};
+    sizeControlProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES;
+
+    VkPhysicalDeviceSubgroupProperties subgroupProperties{};
+    subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+    if (coreSizeControl || extSizeControl)
+        subgroupProperties.pNext = &sizeControlProperties;
+
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &subgroupProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    caps.subgroupSize = subgroupProperties.subgroupSize;
+    caps.supportedStages = subgroupProperties.supportedStages;
+    caps.supportedOperations = subgroupProperties.supportedOperations;
+
+    if (coreSizeControl || extSizeControl) {
+        VkPhysicalDeviceSubgroupSizeControlFeatures sizeControlFeatures{};
+        sizeControlFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES;
+
+        VkPhysicalDeviceFeatures2 features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &sizeControlFeatures;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+
+        caps.sizeControl = sizeControlFeatures.subgroupSizeControl == VK_TRUE;
+        caps.computeFullSubgroups = sizeControlFeatures.computeFullSubgroups == VK_TRUE;
+        caps.minSubgroupSize = sizeControlProperties.minSubgroupSize;
+        caps.maxSubgroupSize = sizeControlProperties.maxSubgroupSize;
+        caps.maxComputeWorkgroupSubgroups = sizeControlProperties.maxComputeWorkgroupSubgroups;
+        caps.requiredSubgroupSizeStages = sizeControlProperties.requiredSubgroupSizeStages;
+        caps.needsSizeControlExtension = !coreSizeControl;
+    }
+
+    return caps;
+}
+
+static void PrintSubgroupCapabilities(const SubgroupCapabilities& caps) {
+    std::cout << "Subgroup Size: " << caps.subgroupSize << std::endl;
+    std::cout << "Subgroup Supported Stages: ";
+    for (VkShaderStageFlagBits bit = VK_SHADER_STAGE_VERTEX_BIT; bit <= VK_SHADER_STAGE_COMPUTE_BIT; bit = static_cast<VkShaderStageFlagBits>(bit << 1))
+    {
+        if (caps.supportedStages & bit)
+            std::cout << magic_enum::enum_name(bit) << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Subgroup Supported Operations: ";
+    for (VkSubgroupFeatureFlagBits bit = VK_SUBGROUP_FEATURE_BASIC_BIT; bit <= VK_SUBGROUP_FEATURE_QUAD_BIT; bit = static_cast<VkSubgroupFeatureFlagBits>(bit << 1))
+    {
+        if (!(caps.supportedOperations & bit))
+            continue;
+
+        // 较新的头文件可能加入 magic_enum 不认识的位，此时输出数值
+        if (magic_enum::enum_contains<VkSubgroupFeatureFlagBits>(bit))
+            std::cout << magic_enum::enum_name(bit) << " ";
+        else
+            std::cout << "0x" << std::hex << static_cast<uint32_t>(bit) << std::dec << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "Subgroup Size Control: " << caps.sizeControl << std::endl;
+    if (caps.sizeControl) {
+        std::cout << "\tMin Subgroup Size: " << caps.minSubgroupSize << std::endl;
+        std::cout << "\tMax Subgroup Size: " << caps.maxSubgroupSize << std::endl;
+        std::cout << "\tMax Compute Workgroup Subgroups: " << caps.maxComputeWorkgroupSubgroups << std::endl;
+        std::cout << "\tCompute Full Subgroups: " << caps.computeFullSubgroups << std::endl;
+        std::cout << "\tRequired Subgroup Size In Compute: " << static_cast<bool>(caps.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT) << std::endl;
+    }
+
+    std::cout << "Max Compute Shared Memory Size: " << caps.maxComputeSharedMemorySize << std::endl;
+    std::cout << "Max Compute Workgroup Invocations: " << caps.maxComputeWorkGroupInvocations << std::endl;
+}
+
+// 基准测试所用的计算着色器，WG_SIZE / TILE 通过宏在编译时替换，每种配置单独编译
+static const char* reduceShaderSource = R"(#version 450
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+layout(local_size_x = WG_SIZE) in;
+layout(std430, binding = 0) readonly buffer Input { float data[]; };
+layout(std430, binding = 1) writeonly buffer Output { float result[]; };
+layout(push_constant) uniform Params { uint count; };
+shared float partials[WG_SIZE];
+
+void main() {
+    float sum = 0.0;
+    for (uint i = gl_GlobalInvocationID.x; i < count; i += gl_NumWorkGroups.x * WG_SIZE)
+        sum += data[i];
+
+    sum = subgroupAdd(sum);
+    if (subgroupElect())
+        partials[gl_SubgroupID] = sum;
+    barrier();
+
+    if (gl_SubgroupID == 0) {
+        float total = 0.0;
+        for (uint i = gl_SubgroupInvocationID; i < gl_NumSubgroups; i += gl_SubgroupSize)
+            total += partials[i];
+        total = subgroupAdd(total);
+        if (subgroupElect())
+            result[gl_WorkGroupID.x] = total;
+    }
+}
+)";
+
+static const char* scanShaderSource = R"(#version 450
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+layout(local_size_x = WG_SIZE) in;
+layout(std430, binding = 0) readonly buffer Input { float data[]; };
+layout(std430, binding = 1) writeonly buffer Output { float result[]; };
+layout(push_constant) uniform Params { uint count; };
+shared float partials[WG_SIZE];
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    float value = index < count ? data[index] : 0.0;
+    float scan = subgroupInclusiveAdd(value);
+    float total = subgroupAdd(value);
+    if (subgroupElect())
+        partials[gl_SubgroupID] = total;
+    barrier();
+
+    // 第一个子组把各子组的总和转换为前缀偏移
+    if (gl_SubgroupID == 0) {
+        float carry = 0.0;
+        for (uint base = 0; base < gl_NumSubgroups; base += gl_SubgroupSize) {
+            uint i = base + gl_SubgroupInvocationID;
+            float partial = i < gl_NumSubgroups ? partials[i] : 0.0;
+            float exclusive = subgroupExclusiveAdd(partial);
+            if (i < gl_NumSubgroups)
+                partials[i] = carry + exclusive;
+            carry += subgroupAdd(partial);
+        }
     }
+    barrier();
+
+    if (index < count)
+        result[index] = scan + partials[gl_SubgroupID];
+}
+)";
+
+static const char* tiledMatmulShaderSource = R"(#version 450
+layout(local_size_x = TILE, local_size_y = TILE) in;
+layout(std430, binding = 0) readonly buffer Input { float data[]; };
+layout(std430, binding = 1) writeonly buffer Output { float result[]; };
+layout(push_constant) uniform Params { uint count; };
+shared float tileA[TILE][TILE];
+shared float tileB[TILE][TILE];
+
+void main() {
+    uint row = gl_GlobalInvocationID.y;
+    uint col = gl_GlobalInvocationID.x;
+    uint lx = gl_LocalInvocationID.x;
+    uint ly = gl_LocalInvocationID.y;
+
+    float sum = 0.0;
+    for (uint t = 0; t < count; t += TILE) {
+        tileA[ly][lx] = data[row * count + t + lx];
+        tileB[ly][lx] = data[(t + ly) * count + col];
+        barrier();
+        for (uint k = 0; k < TILE; ++k)
+            sum += tileA[ly][k] * tileB[k][lx];
+        barrier();
+    }
+    result[row * count + col] = sum;
+}
+)";
+
+enum class ComputeKernel {
+    Reduce,
+    Scan,
+    TiledMatmul,
+};
 
-    // 告诉 GLFW 不要创建 OpenGL 上下文
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+struct ComputeBenchmarkResult {
+    ComputeKernel kernel;
+    uint32_t subgroupSize;  // 0 表示驱动默认值
+    uint32_t workgroupX;
+    uint32_t workgroupY;
+    double throughput;      // Reduce/Scan 为 GB/s，TiledMatmul 为 GFLOPS
+};
+
+struct ComputeContext {
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    bool hasTimestamps = false;
+    uint64_t timestampMask = 0;         // 由队列族的 timestampValidBits 决定，计数器回绕时差值需要按位截断
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkBuffer buffers[3] = {};           // 输入、输出、主机可见的中转缓冲
+    VkDeviceMemory memories[3] = {};
+    void* stagingData = nullptr;
+    VkDeviceSize bufferSize = 0;
+};
+
+static const uint32_t kReduceElementCount = 1u << 22;
+static const uint32_t kMatrixDimension = 512;
+static const uint32_t kBenchmarkIterations = 5;
+
+static uint32_t FindMemoryType(VkPhysicalDevice physicalDevice, uint32_t typeBits, VkMemoryPropertyFlags flags) {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+            return i;
+    }
+    return UINT32_MAX;
+}
 
-    // 创建一个隐藏的窗口以用于 Vulkan 初始化
-    GLFWwindow* window = glfwCreateWindow(800, 600, "Vulkan Window", nullptr, nullptr);
+static bool CreateBuffer(ComputeContext& ctx, int index, VkBufferUsageFlags usage, VkMemoryPropertyFlags flags) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = ctx.bufferSize;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (vkCreateBuffer(ctx.device, &bufferInfo, nullptr, &ctx.buffers[index]) != VK_SUCCESS)
+        return false;
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(ctx.device, ctx.buffers[index], &requirements);
+
+    // 优先使用 device local 内存，统一内存架构上两者可以同时满足
+    uint32_t memoryType = FindMemoryType(ctx.physicalDevice, requirements.memoryTypeBits, flags);
+    if (memoryType == UINT32_MAX && !(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        memoryType = FindMemoryType(ctx.physicalDevice, requirements.memoryTypeBits, 0);
+    if (memoryType == UINT32_MAX)
+        return false;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = memoryType;
+    if (vkAllocateMemory(ctx.device, &allocInfo, nullptr, &ctx.memories[index]) != VK_SUCCESS)
+        return false;
+
+    return vkBindBufferMemory(ctx.device, ctx.buffers[index], ctx.memories[index], 0) == VK_SUCCESS;
+}
+
+static void DestroyComputeContext(ComputeContext& ctx) {
+    if (ctx.device == VK_NULL_HANDLE)
+        return;
+
+    vkDeviceWaitIdle(ctx.device);
+    for (int i = 0; i < 3; i++) {
+        if (ctx.buffers[i] != VK_NULL_HANDLE)
+            vkDestroyBuffer(ctx.device, ctx.buffers[i], nullptr);
+        if (ctx.memories[i] != VK_NULL_HANDLE)
+            vkFreeMemory(ctx.device, ctx.memories[i], nullptr);
+    }
+    if (ctx.pipelineLayout != VK_NULL_HANDLE)
+        vkDestroyPipelineLayout(ctx.device, ctx.pipelineLayout, nullptr);
+    if (ctx.descriptorPool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(ctx.device, ctx.descriptorPool, nullptr);
+    if (ctx.descriptorSetLayout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(ctx.device, ctx.descriptorSetLayout, nullptr);
+    if (ctx.queryPool != VK_NULL_HANDLE)
+        vkDestroyQueryPool(ctx.device, ctx.queryPool, nullptr);
+    if (ctx.commandPool != VK_NULL_HANDLE)
+        vkDestroyCommandPool(ctx.device, ctx.commandPool, nullptr);
+    vkDestroyDevice(ctx.device, nullptr);
+    ctx.device = VK_NULL_HANDLE;
+}
+
+static bool CreateComputeContext(VkPhysicalDevice physicalDevice, const SubgroupCapabilities& caps, ComputeContext& ctx) {
+    ctx.physicalDevice = physicalDevice;
+
+    // 选择一个支持计算的队列族
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    bool found = false;
+    for (uint32_t i = 0; i < queueFamilyCount && !found; ++i) {
+        if (queueFamilies[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+            ctx.queueFamily = i;
+            ctx.hasTimestamps = queueFamilies[i].timestampValidBits > 0 && caps.timestampPeriod > 0.0f;
+            uint32_t validBits = queueFamilies[i].timestampValidBits;
+            ctx.timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    float queuePriority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo{};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = ctx.queueFamily;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &queuePriority;
+
+    VkPhysicalDeviceSubgroupSizeControlFeatures sizeControlFeatures{};
+    sizeControlFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES;
+    sizeControlFeatures.subgroupSizeControl = caps.sizeControl ? VK_TRUE : VK_FALSE;
+    sizeControlFeatures.computeFullSubgroups = caps.computeFullSubgroups ? VK_TRUE : VK_FALSE;
+
+    std::vector<const char*> deviceExtensions;
+    if (caps.sizeControl && caps.needsSizeControlExtension)
+        deviceExtensions.push_back(VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+
+    VkDeviceCreateInfo deviceInfo{};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.pNext = caps.sizeControl ? &sizeControlFeatures : nullptr;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    if (vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &ctx.device) != VK_SUCCESS)
+        return false;
+
+    vkGetDeviceQueue(ctx.device, ctx.queueFamily, 0, &ctx.queue);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = ctx.queueFamily;
+    if (vkCreateCommandPool(ctx.device, &poolInfo, nullptr, &ctx.commandPool) != VK_SUCCESS)
+        return false;
+
+    VkCommandBufferAllocateInfo commandBufferInfo{};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferInfo.commandPool = ctx.commandPool;
+    commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(ctx.device, &commandBufferInfo, &ctx.commandBuffer) != VK_SUCCESS)
+        return false;
+
+    if (ctx.hasTimestamps) {
+        VkQueryPoolCreateInfo queryInfo{};
+        queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        queryInfo.queryCount = 2;
+        if (vkCreateQueryPool(ctx.device, &queryInfo, nullptr, &ctx.queryPool) != VK_SUCCESS)
+            ctx.hasTimestamps = false;
+    }
+
+    // 输入与输出都需要容纳归约数组和整个矩阵
+    ctx.bufferSize = sizeof(float) * std::max<VkDeviceSize>(kReduceElementCount, kMatrixDimension * kMatrixDimension);
+    const VkBufferUsageFlags storageUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if (!CreateBuffer(ctx, 0, storageUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        || !CreateBuffer(ctx, 1, storageUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        || !CreateBuffer(ctx, 2, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+        return false;
+
+    if (vkMapMemory(ctx.device, ctx.memories[2], 0, ctx.bufferSize, 0, &ctx.stagingData) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorSetLayoutBinding bindings[2]{};
+    for (uint32_t i = 0; i < 2; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &ctx.descriptorSetLayout) != VK_SUCCESS)
+        return false;
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.size = sizeof(uint32_t);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &ctx.descriptorSetLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &ctx.pipelineLayout) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 };
+    VkDescriptorPoolCreateInfo descriptorPoolInfo{};
+    descriptorPoolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptorPoolInfo.maxSets = 1;
+    descriptorPoolInfo.poolSizeCount = 1;
+    descriptorPoolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(ctx.device, &descriptorPoolInfo, nullptr, &ctx.descriptorPool) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorSetAllocateInfo setInfo{};
+    setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    setInfo.descriptorPool = ctx.descriptorPool;
+    setInfo.descriptorSetCount = 1;
+    setInfo.pSetLayouts = &ctx.descriptorSetLayout;
+    if (vkAllocateDescriptorSets(ctx.device, &setInfo, &ctx.descriptorSet) != VK_SUCCESS)
+        return false;
+
+    VkDescriptorBufferInfo bufferInfos[2] = {
+        { ctx.buffers[0], 0, VK_WHOLE_SIZE },
+        { ctx.buffers[1], 0, VK_WHOLE_SIZE },
+    };
+    VkWriteDescriptorSet writes[2]{};
+    for (uint32_t i = 0; i < 2; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = ctx.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(ctx.device, 2, writes, 0, nullptr);
+
+    return true;
+}
+
+static void SubmitAndWait(ComputeContext& ctx) {
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &ctx.commandBuffer;
+    vkQueueSubmit(ctx.queue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(ctx.queue);
+}
+
+static void BeginCommands(ComputeContext& ctx) {
+    vkResetCommandBuffer(ctx.commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(ctx.commandBuffer, &beginInfo);
+}
+
+// 通过中转缓冲在输入缓冲与主机之间拷贝数据。
+// 等待队列空闲只保证执行完成，不保证写入可见：拷贝前需要等之前调度的着色器写入，
+// 拷贝后需要让写入对主机读取（回读结果）和之后的着色器读取（上传输入）可见
+static void CopyBuffer(ComputeContext& ctx, VkBuffer src, VkBuffer dst) {
+    BeginCommands(ctx);
+
+    VkMemoryBarrier beforeCopy{};
+    beforeCopy.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    beforeCopy.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    beforeCopy.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(ctx.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &beforeCopy, 0, nullptr, 0, nullptr);
+
+    VkBufferCopy region{ 0, 0, ctx.bufferSize };
+    vkCmdCopyBuffer(ctx.commandBuffer, src, dst, 1, &region);
+
+    VkMemoryBarrier afterCopy{};
+    afterCopy.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    afterCopy.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    afterCopy.dstAccessMask = VK_ACCESS_HOST_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(ctx.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &afterCopy, 0, nullptr, 0, nullptr);
+
+    vkEndCommandBuffer(ctx.commandBuffer);
+    SubmitAndWait(ctx);
+}
+
+static VkShaderModule CompileComputeShader(VkDevice device, const char* source, const char* name, const char* macro, uint32_t value) {
+    shaderc::Compiler compiler;
+    shaderc::CompileOptions options;
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    options.AddMacroDefinition(macro, std::to_string(value));
+
+    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(source, shaderc_compute_shader, name, options);
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+        std::cerr << "Failed to compile " << name << ": " << result.GetErrorMessage() << std::endl;
+        return VK_NULL_HANDLE;
+    }
+
+    std::vector<uint32_t> spirv(result.cbegin(), result.cend());
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = spirv.size() * sizeof(uint32_t);
+    moduleInfo.pCode = spirv.data();
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &module) != VK_SUCCESS) {
+        std::cerr << "Failed to create shader module " << name << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    return module;
+}
+
+// 编译并运行一种配置，校验结果后返回吞吐量，失败时返回 0
+static double RunComputeVariant(ComputeContext& ctx, const SubgroupCapabilities& caps, ComputeKernel kernel, uint32_t subgroupSize, uint32_t workgroupSize) {
+    const char* source = nullptr;
+    const char* macro = "WG_SIZE";
+    uint32_t count = 0;
+    uint32_t groupsX = 1, groupsY = 1;
+    double workPerDispatch = 0.0;
+
+    switch (kernel) {
+    case ComputeKernel::Reduce:
+        source = reduceShaderSource;
+        count = kReduceElementCount;
+        groupsX = std::min(count / (workgroupSize * 16), caps.maxComputeWorkGroupCount);
+        workPerDispatch = count * sizeof(float) / 1.0e9;
+        break;
+    case ComputeKernel::Scan:
+        source = scanShaderSource;
+        groupsX = std::min(kReduceElementCount / workgroupSize, caps.maxComputeWorkGroupCount);
+        count = groupsX * workgroupSize;
+        workPerDispatch = 2.0 * count * sizeof(float) / 1.0e9;
+        break;
+    case ComputeKernel::TiledMatmul:
+        source = tiledMatmulShaderSource;
+        macro = "TILE";
+        count = kMatrixDimension;
+        groupsX = groupsY = kMatrixDimension / workgroupSize;
+        workPerDispatch = 2.0 * kMatrixDimension * kMatrixDimension * kMatrixDimension / 1.0e9;
+        break;
+    }
+
+    std::string name = std::string(magic_enum::enum_name(kernel)) + "_" + std::to_string(workgroupSize);
+    VkShaderModule module = CompileComputeShader(ctx.device, source, name.c_str(), macro, workgroupSize);
+    if (module == VK_NULL_HANDLE)
+        return 0.0;
+
+    VkPipelineShaderStageRequiredSubgroupSizeCreateInfo requiredSubgroupSize{};
+    requiredSubgroupSize.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO;
+    requiredSubgroupSize.requiredSubgroupSize = subgroupSize;
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = module;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = ctx.pipelineLayout;
+    if (subgroupSize != 0) {
+        pipelineInfo.stage.pNext = &requiredSubgroupSize;
+        // 要求完整子组时规范只约束 X 维：local_size_x 必须是子组大小的整数倍（二维的矩阵乘法同样只看 X）
+        if (caps.computeFullSubgroups && workgroupSize % subgroupSize == 0)
+            pipelineInfo.stage.flags = VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT;
+    }
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateComputePipelines(ctx.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(ctx.device, module, nullptr);
+    if (result != VK_SUCCESS)
+        return 0.0;
+
+    // 第一次提交用于预热，第二次计时；两次调度之间插入屏障，避免对同一输出缓冲的写写冲突
+    double elapsedMs = 0.0;
+    for (int pass = 0; pass < 2; pass++) {
+        bool timed = pass == 1;
+        BeginCommands(ctx);
+        if (timed && ctx.hasTimestamps) {
+            vkCmdResetQueryPool(ctx.commandBuffer, ctx.queryPool, 0, 2);
+            vkCmdWriteTimestamp(ctx.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, ctx.queryPool, 0);
+        }
+
+        vkCmdBindPipeline(ctx.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        vkCmdBindDescriptorSets(ctx.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ctx.pipelineLayout, 0, 1, &ctx.descriptorSet, 0, nullptr);
+        vkCmdPushConstants(ctx.commandBuffer, ctx.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(count), &count);
+
+        uint32_t iterations = timed ? kBenchmarkIterations : 1;
+        for (uint32_t i = 0; i < iterations; i++) {
+            if (i > 0) {
+                VkMemoryBarrier barrier{};
+                barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                vkCmdPipelineBarrier(ctx.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+            }
+            vkCmdDispatch(ctx.commandBuffer, groupsX, groupsY, 1);
+        }
+
+        if (timed && ctx.hasTimestamps)
+            vkCmdWriteTimestamp(ctx.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, ctx.queryPool, 1);
+        vkEndCommandBuffer(ctx.commandBuffer);
+
+        auto start = std::chrono::steady_clock::now();
+        SubmitAndWait(ctx);
+        elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (ctx.hasTimestamps) {
+        uint64_t timestamps[2] = {};
+        if (vkGetQueryPoolResults(ctx.device, ctx.queryPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) == VK_SUCCESS)
+            elapsedMs = static_cast<double>((timestamps[1] - timestamps[0]) & ctx.timestampMask) * caps.timestampPeriod / 1.0e6;
+    }
+    vkDestroyPipeline(ctx.device, pipeline, nullptr);
+
+    // 输入全为 1，逐项校验输出
+    CopyBuffer(ctx, ctx.buffers[1], ctx.buffers[2]);
+    const float* output = static_cast<const float*>(ctx.stagingData);
+    bool valid = true;
+    if (kernel == ComputeKernel::Reduce) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < groupsX; i++)
+            sum += output[i];
+        valid = sum == static_cast<double>(count);
+    }
+    else if (kernel == ComputeKernel::Scan) {
+        for (uint32_t i = 0; i < count && valid; i += 997)
+            valid = output[i] == static_cast<float>(i % workgroupSize + 1);
+    }
+    else {
+        for (uint32_t i = 0; i < kMatrixDimension * kMatrixDimension && valid; i += 997)
+            valid = output[i] == static_cast<float>(kMatrixDimension);
+    }
+
+    if (!valid) {
+        std::cerr << "\t" << name << " produced wrong results" << std::endl;
+        return 0.0;
+    }
+    if (elapsedMs <= 0.0)
+        return 0.0;
+
+    return workPerDispatch * kBenchmarkIterations / (elapsedMs / 1000.0);
+}
+
+// 在每种支持的子组大小与工作组形状下运行归约、前缀和与共享内存分块矩阵乘，返回各内核最快的配置
+static std::vector<ComputeBenchmarkResult> RunSubgroupBenchmark(VkPhysicalDevice physicalDevice, const SubgroupCapabilities& caps) {
+    std::vector<ComputeBenchmarkResult> best;
+
+    // 所有内核都以 Vulkan 1.1（SPIR-V 1.3）为目标编译，1.0 设备无法加载
+    if (!caps.vulkan11) {
+        std::cout << "Vulkan 1.1 not supported, skipping compute benchmark" << std::endl;
+        return best;
+    }
+
+    const VkSubgroupFeatureFlags requiredOperations = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+    bool hasSubgroupArithmetic = (caps.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT)
+        && (caps.supportedOperations & requiredOperations) == requiredOperations;
+    if (!hasSubgroupArithmetic)
+        std::cout << "Subgroup arithmetic not supported in compute, skipping reduce/scan" << std::endl;
+
+    ComputeContext ctx;
+    if (!CreateComputeContext(physicalDevice, caps, ctx)) {
+        std::cerr << "Failed to create compute context" << std::endl;
+        DestroyComputeContext(ctx);
+        return best;
+    }
+
+    float* input = static_cast<float*>(ctx.stagingData);
+    for (VkDeviceSize i = 0; i < ctx.bufferSize / sizeof(float); i++)
+        input[i] = 1.0f;
+    CopyBuffer(ctx, ctx.buffers[2], ctx.buffers[0]);
+
+    // 支持子组大小控制时遍历 [min, max] 内的所有 2 的幂，否则只测驱动默认值
+    std::vector<uint32_t> subgroupSizes;
+    if (caps.sizeControl && (caps.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT)) {
+        for (uint32_t size = caps.minSubgroupSize; size <= caps.maxSubgroupSize; size *= 2)
+            subgroupSizes.push_back(size);
+    }
+    if (subgroupSizes.empty())
+        subgroupSizes.push_back(0);
+
+    for (ComputeKernel kernel : { ComputeKernel::Reduce, ComputeKernel::Scan, ComputeKernel::TiledMatmul }) {
+        if (kernel != ComputeKernel::TiledMatmul && !hasSubgroupArithmetic)
+            continue;
+
+        std::vector<uint32_t> shapes;
+        if (kernel == ComputeKernel::TiledMatmul)
+            shapes = { 8, 16, 32 };
+        else
+            shapes = { 64, 128, 256, 512, 1024 };
+
+        ComputeBenchmarkResult fastest{ kernel, 0, 0, 0, 0.0 };
+        for (uint32_t subgroupSize : subgroupSizes) {
+            for (uint32_t shape : shapes) {
+                uint32_t invocations = kernel == ComputeKernel::TiledMatmul ? shape * shape : shape;
+                uint32_t sharedMemory = static_cast<uint32_t>((kernel == ComputeKernel::TiledMatmul ? 2 * shape * shape : shape) * sizeof(float));
+                if (invocations > caps.maxComputeWorkGroupInvocations || shape > caps.maxComputeWorkGroupSize[0]
+                    || (kernel == ComputeKernel::TiledMatmul && shape > caps.maxComputeWorkGroupSize[1])
+                    || sharedMemory > caps.maxComputeSharedMemorySize)
+                    continue;
+                if (subgroupSize != 0 && invocations > subgroupSize * caps.maxComputeWorkgroupSubgroups)
+                    continue;
+
+                double throughput = RunComputeVariant(ctx, caps, kernel, subgroupSize, shape);
+                uint32_t shapeY = kernel == ComputeKernel::TiledMatmul ? shape : 1;
+                std::cout << "\t" << magic_enum::enum_name(kernel) << " subgroup " << (subgroupSize ? std::to_string(subgroupSize) : std::string("default"))
+                    << " workgroup " << shape << "x" << shapeY << ": " << throughput
+                    << (kernel == ComputeKernel::TiledMatmul ? " GFLOPS" : " GB/s") << std::endl;
+
+                if (throughput > fastest.throughput)
+                    fastest = { kernel, subgroupSize, shape, shapeY, throughput };
+            }
+        }
+
+        if (fastest.throughput > 0.0)
+            best.push_back(fastest);
+    }
+
+    DestroyComputeContext(ctx);
+    return best;
+}
+
+int main() {
+    // 初始化 GLFW 库；没有显示环境时（例如只有 lavapipe 的 CI 机器）跳过窗口，设备查询不依赖窗口
+    bool hasGlfw = glfwInit() == GLFW_TRUE;
+    GLFWwindow* window = nullptr;
+    if (hasGlfw) {
+        // 告诉 GLFW 不要创建 OpenGL 上下文
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+        // 创建一个隐藏的窗口以用于 Vulkan 初始化
+        window = glfwCreateWindow(800, 600, "Vulkan Window", nullptr, nullptr);
+    }
+    else {
+        std::cerr << "Failed to initialize GLFW, continuing without window" << std::endl;
+    }
 
     // 创建 Vulkan 实例
     VkInstance instance;
@@ -61,8 +908,62 @@ int main() {
     std::vector<VkPhysicalDevice> physicalDevices(deviceCount);
     vkEnumeratePhysicalDevices(instance, &deviceCount, physicalDevices.data());
 
-    // 选择第一个物理设备进行查询
-    VkPhysicalDevice physicalDevice = physicalDevices[0];
+    // 对所有物理设备排序，选择得分最高的设备进行查询，避免在多 GPU 机器上选中集显
+    std::vector<GpuDeviceCandidate> candidates;
+    for (VkPhysicalDevice device : physicalDevices)
+        candidates.push_back(DescribePhysicalDevice(device));
+
+    // 在每个设备上运行子组与共享内存内核并记录最快的配置，归约吞吐同时作为设备排序的实测依据
+    for (size_t i = 0; i < physicalDevices.size(); ++i) {
+        std::cout << "Compute Benchmark: " << candidates[i].identity.name << std::endl;
+        SubgroupCapabilities caps = QuerySubgroupCapabilities(physicalDevices[i]);
+        PrintSubgroupCapabilities(caps);
+
+        for (const auto& result : RunSubgroupBenchmark(physicalDevices[i], caps)) {
+            std::cout << "Fastest " << magic_enum::enum_name(result.kernel) << ": subgroup "
+                << (result.subgroupSize ? std::to_string(result.subgroupSize) : std::string("default"))
+                << ", workgroup " << result.workgroupX << "x" << result.workgroupY << ", " << result.throughput
+                << (result.kernel == ComputeKernel::TiledMatmul ? " GFLOPS" : " GB/s") << std::endl;
+
+            if (result.kernel == ComputeKernel::Reduce)
+                candidates[i].measuredThroughput = result.throughput;
+        }
+    }
+
+#ifdef __linux__
+    // 通过 PCI 地址（或唯一的型号）关联到 sysfs 设备，补充 Vulkan 不提供的驱动、NUMA 与 PCIe 链路信息
+    std::vector<PciGpuInfo> sysfsGpus = GetSysfsGpuInfo("/sys");
+    std::vector<GpuDeviceIdentity> vulkanIdentities, sysfsIdentities;
+    for (const auto& candidate : candidates)
+        vulkanIdentities.push_back(candidate.identity);
+    for (const auto& gpu : sysfsGpus)
+        sysfsIdentities.push_back(GetSysfsIdentity(gpu));
+    std::vector<int> sysfsMatches = CorrelateDevices(vulkanIdentities, sysfsIdentities);
+#endif
+
+    std::vector<size_t> ranking = RankDevices(candidates);
+    std::cout << "Device Ranking: " << std::endl;
+    for (size_t rank = 0; rank < ranking.size(); ++rank) {
+        const GpuDeviceCandidate& candidate = candidates[ranking[rank]];
+        std::cout << "\t" << rank << ": " << candidate.identity.name
+            << " (" << magic_enum::enum_name(candidate.kind) << ", score " << ScoreDevice(candidate)
+            << ", measured " << candidate.measuredThroughput << " GB/s)" << std::endl;
+        std::cout << "\t\tDevice Key: " << FormatDeviceKey(candidate.identity) << std::endl;
+
+#ifdef __linux__
+        int match = sysfsMatches[ranking[rank]];
+        if (match >= 0) {
+            const PciGpuInfo& gpu = sysfsGpus[match];
+            std::cout << "\t\tSysfs: " << gpu.pciAddress << ", driver " << (gpu.driverName.empty() ? "none" : gpu.driverName)
+                << ", NUMA node " << gpu.numaNode;
+            if (!gpu.maxLinkSpeed.empty())
+                std::cout << ", PCIe " << gpu.currentLinkSpeed << " x" << gpu.currentLinkWidth;
+            std::cout << std::endl;
+        }
+#endif
+    }
+
+    VkPhysicalDevice physicalDevice = physicalDevices[ranking[0]];
 
     // 查询物理设备的特性
     VkPhysicalDeviceFeatures deviceFeatures;
@@ -145,8 +1046,10 @@ int main() {
 
     // 清理资源
     vkDestroyInstance(instance, nullptr);
-    glfwDestroyWindow(window);
-    glfwTerminate();
+    if (hasGlfw) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
 
     system("pause");
     return 0;